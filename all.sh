@@ -1,6 +1,8 @@
 #!/bin/env sh
 
 make test &&
+make stress &&
+make tsan &&
 ./release.sh &&
 ./win-debug.sh &&
 ./win-release.sh
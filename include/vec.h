@@ -98,8 +98,7 @@ SOFTWARE.
 	vec_##T##_t vec_##T##_new() {\
 		vec_##T##_t vec = {0};\
 		vec.__priv = vec_new(sizeof(T));\
-		if (!vec.__priv) vec.is_init = 0;\
-		vec.is_init = 1;\
+		vec.is_init = vec.__priv != NULL;\
 		vec.push = vec_##T##_push;\
 		vec.pop = vec_##T##_pop;\
 		vec.at = vec_##T##_at;\
@@ -114,9 +113,8 @@ SOFTWARE.
 	}\
 	vec_##T##_t vec_##T##_new_with_capacity(size_t capacity) {\
 		vec_##T##_t vec = {0};\
-		if (!vec.__priv) vec.is_init = 0;\
-		vec.is_init = 1;\
 		vec.__priv = vec_new_with_capacity(sizeof(T), capacity);\
+		vec.is_init = vec.__priv != NULL;\
 		vec.push = vec_##T##_push;\
 		vec.pop = vec_##T##_pop;\
 		vec.at = vec_##T##_at;\
@@ -160,6 +158,38 @@ vec_t *vec_new_with_capacity(size_t sizeof_type, size_t capacity);
  * vec_get_err(). */
 int vec_push(vec_t *vec, size_t sizeof_type, const void *data);
 
+/** Appends a number of contiguous elements at the end of the vector,
+ * reallocating it at most once.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param data A pointer to the first element to be appended. May point
+ * into the vector itself.
+ * \param count The number of elements to be appended.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_append(vec_t *vec, size_t sizeof_type, const void *data, size_t count);
+
+/** Makes room for a number of elements at the end of the vector without
+ * adding them, so they can be filled in place, e.g. by a read() call.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param count The number of elements to make room for.
+ * \returns A pointer to the first unused element or NULL on failure.
+ * The pointer is invalidated by any call that reallocates the vector.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+void *vec_reserve(vec_t *vec, size_t sizeof_type, size_t count);
+
+/** Adds elements filled in place after vec_reserve() to the vector.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param count The number of elements to add.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_commit(vec_t *vec, size_t sizeof_type, size_t count);
+
 /** Remove the last element of the vector, shrinking it if necessary.
  * \param vec A pointer to the vector.
  * \param sizeof_type The size of the underlying type.
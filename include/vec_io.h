@@ -0,0 +1,91 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file include/vec_io.h
+ * \brief Public header file for streaming vectors from and to files.
+ * \details This file contains the function prototypes that read records
+ * from file descriptors straight into the spare capacity of a vector and
+ * write vectors out straight from their storage, without intermediate
+ * buffers. On Linux, vec_io_read_at() overlaps several reads of a large
+ * file region with io_uring. It falls back to sequential reads for short
+ * regions and where io_uring is not available. */
+
+#ifndef VEC_IO_H
+#define VEC_IO_H
+
+#include "vec.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** Returned by vec_io_read() when a non-blocking descriptor has no data
+ * available. */
+#define VEC_IO_WOULD_BLOCK ((size_t)-2)
+
+/** Reads up to count elements from a file descriptor, such as a pipe or
+ * a socket, and appends them to the vector. On a blocking descriptor it
+ * waits until at least one element is available. Once part of an element
+ * has been read, it waits for the rest even on a non-blocking descriptor,
+ * so the stream never loses its element alignment.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param fd The file descriptor to read from.
+ * \param count The maximum number of elements to read.
+ * \returns The number of elements appended, 0 at the end of the file,
+ * VEC_IO_WOULD_BLOCK if a non-blocking descriptor had no data or
+ * (size_t)-1 on failure. A partial element at the end of the file is not
+ * appended. On failure, the whole elements read before the error are
+ * still appended.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_io_read(vec_t *vec, size_t sizeof_type, int fd, size_t count);
+
+/** Reads up to count elements from a file starting at a byte offset and
+ * appends them to the vector, keeping up to depth reads in flight. For
+ * regular files, count is first limited to the elements the file holds
+ * after offset, so a generous count doesn't reserve unused capacity. The
+ * file position is not used or changed, except on Windows, which lacks a
+ * positional read and moves it.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param fd The file descriptor of a regular file to read from.
+ * \param offset The byte offset to start reading at.
+ * \param count The maximum number of elements to read.
+ * \param depth The maximum number of concurrent reads.
+ * \returns The number of elements appended, which is less than count only
+ * if the end of the file was reached, or (size_t)-1 on failure. A partial
+ * element at the end of the file is not appended.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_io_read_at(vec_t *vec, size_t sizeof_type, int fd, uint64_t offset, size_t count, size_t depth);
+
+/** Writes all the elements of the vector to a file descriptor.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param fd The file descriptor to write to.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_io_write(const vec_t *vec, size_t sizeof_type, int fd);
+
+#endif
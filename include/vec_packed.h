@@ -0,0 +1,103 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file include/vec_packed.h
+ * \brief Public header file for the compressed integer vector.
+ * \details This file contains the function prototypes of vec_packed_t,
+ * an append-optimized vector of integers that stores its elements in
+ * frames of VEC_PACKED_FRAME values. Each full frame keeps its first value
+ * and the zigzag encoded deltas of the rest bit-packed to the smallest
+ * width that fits them, so slowly changing columns, such as ids and
+ * timestamps, take a fraction of the memory of a plain vector. */
+
+#ifndef VEC_PACKED_H
+#define VEC_PACKED_H
+
+#include "vec.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** The number of values in a frame. */
+#define VEC_PACKED_FRAME 128LU
+
+/** Opaque compressed integer vector type. */
+typedef struct vec_packed vec_packed_t;
+
+/** Creates a new, empty vec_packed_t on the heap.
+ * \returns A pointer to the allocated vector object or NULL
+ * on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+vec_packed_t *vec_packed_new(void);
+
+/** Appends a value at the end of the vector. Every VEC_PACKED_FRAME-th
+ * push compresses the pending values into a new frame.
+ * \param vec A pointer to the vector.
+ * \param value The value to be appended.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_packed_push(vec_packed_t *vec, int64_t value);
+
+/** Get a copy of a specific member of the vector. Only the frame holding
+ * the element is decoded.
+ * \param vec A pointer to the vector.
+ * \param index The index of the element.
+ * \param value A pointer to the location the value is copied to.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_packed_at(const vec_packed_t *vec, size_t index, int64_t *value);
+
+/** Get the number of elements in the vector.
+ * \param vec A pointer to the vector.
+ * \returns The number of elements or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_packed_size(const vec_packed_t *vec);
+
+/** Get the number of bytes used to store the elements of the vector.
+ * \param vec A pointer to the vector.
+ * \returns The number of bytes or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_packed_bytes(const vec_packed_t *vec);
+
+/** Decodes every element of the vector and appends them to a plain vector
+ * of signed integers. Values that do not fit the destination type are
+ * truncated.
+ * \param vec A pointer to the vector.
+ * \param dst A pointer to the destination vector.
+ * \param sizeof_type The size of the underlying type of dst. Must be
+ * 1, 2, 4 or 8.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_packed_decode(const vec_packed_t *vec, vec_t *dst, size_t sizeof_type);
+
+/** Cleans up all the allocated data associated with the vector.
+ * \param vec A pointer to the vector. */
+void vec_packed_del(vec_packed_t *vec);
+
+#endif
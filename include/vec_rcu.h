@@ -0,0 +1,117 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file include/vec_rcu.h
+ * \brief Public header file for the snapshot-readable vector.
+ * \details This file contains the function prototypes of vec_rcu_t, an
+ * append-only vector for one writer thread and any number of concurrent
+ * reader threads. Growth copies the elements into a new buffer and
+ * publishes it atomically instead of reallocating in place. The old
+ * buffer is only freed once every reader that might still see it has
+ * finished, so readers never lock and always see a consistent (data, size)
+ * snapshot. Readers are identified by a slot index chosen by the caller,
+ * below the number of readers the vector was created with. */
+
+#ifndef VEC_RCU_H
+#define VEC_RCU_H
+
+#include <stddef.h>
+
+/** Opaque snapshot-readable vector type. */
+typedef struct vec_rcu vec_rcu_t;
+
+/** A consistent view of the vector taken by a reader. */
+typedef struct vec_rcu_snapshot {
+
+	/** A pointer to the first element. */
+	const void *data;
+
+	/** The number of elements readable through data. */
+	size_t size;
+} vec_rcu_snapshot_t;
+
+/** Creates a new vec_rcu_t on the heap with the specified capacity.
+ * \param sizeof_type The size of the underlying type.
+ * \param capacity The desired capacity expressed by the number of elements
+ * and not bytes.
+ * \param readers The number of reader slots.
+ * \returns A pointer to the allocated vector object or NULL
+ * on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+vec_rcu_t *vec_rcu_new(size_t sizeof_type, size_t capacity, size_t readers);
+
+/** Appends an element at the end of the vector, moving it to a larger
+ * buffer if necessary. Must only be called by the writer thread.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param data A pointer to the data to be appended.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_rcu_push(vec_rcu_t *vec, size_t sizeof_type, const void *data);
+
+/** Get the number of elements in the vector as seen by the writer.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \returns The number of elements or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_rcu_size(const vec_rcu_t *vec, size_t sizeof_type);
+
+/** Frees the buffers replaced by growth that no reader can see anymore.
+ * Growth already does this, so calling it is only needed to release
+ * memory sooner. Must only be called by the writer thread.
+ * \param vec A pointer to the vector.
+ * \returns The number of replaced buffers still in use by readers or
+ * (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_rcu_reclaim(vec_rcu_t *vec);
+
+/** Takes a snapshot of the vector. The snapshot stays valid until the
+ * matching vec_rcu_read_end() call, regardless of concurrent pushes.
+ * A reader can only hold one snapshot at a time; calling this again
+ * before vec_rcu_read_end() fails.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param reader The slot index of the calling reader.
+ * \param snapshot A pointer to the snapshot to be filled in.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_rcu_read_begin(vec_rcu_t *vec, size_t sizeof_type, size_t reader, vec_rcu_snapshot_t *snapshot);
+
+/** Releases the snapshot taken by a reader.
+ * \param vec A pointer to the vector.
+ * \param reader The slot index of the calling reader. */
+void vec_rcu_read_end(vec_rcu_t *vec, size_t reader);
+
+/** Cleans up all the allocated data associated with the vector. Must only
+ * be called once no reader holds a snapshot.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type. */
+void vec_rcu_del(vec_rcu_t *vec, size_t sizeof_type);
+
+#endif
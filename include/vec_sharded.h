@@ -0,0 +1,119 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file include/vec_sharded.h
+ * \brief Public header file for the sharded vector.
+ * \details This file contains the function prototypes of vec_sharded_t,
+ * a vector composed of independent vec_t shards, one per appending thread
+ * or NUMA node. Each shard is only ever touched by its owner while
+ * appending, so concurrent pushes to different shards need no locking.
+ * A shard's buffer is allocated by the first push to it, which places its
+ * pages on the owner's NUMA node under the default first-touch policy.
+ * Once the appending threads are done, the shards can be read as a single
+ * merged vector in shard order. */
+
+#ifndef VEC_SHARDED_H
+#define VEC_SHARDED_H
+
+#include "vec.h"
+#include <stddef.h>
+
+/** Opaque sharded vector type. */
+typedef struct vec_sharded vec_sharded_t;
+
+/** Creates a new vec_sharded_t on the heap. The shards themselves are
+ * allocated by the first push to each of them.
+ * \param sizeof_type The size of the underlying type.
+ * \param shards The number of shards.
+ * \returns A pointer to the allocated vector object or NULL
+ * on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+vec_sharded_t *vec_sharded_new(size_t sizeof_type, size_t shards);
+
+/** Appends an element at the end of a shard. Must only be called by
+ * the thread owning the shard.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param shard The index of the shard.
+ * \param data A pointer to the data to be appended.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_sharded_push(vec_sharded_t *vec, size_t sizeof_type, size_t shard, const void *data);
+
+/** Get a specific shard as a plain vector. Must only be called by the
+ * thread owning the shard or after all appends have finished.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param shard The index of the shard.
+ * \returns A pointer to the shard or NULL on failure or if nothing has
+ * been pushed to it yet.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+vec_t *vec_sharded_shard(vec_sharded_t *vec, size_t sizeof_type, size_t shard);
+
+/** Get the number of shards.
+ * \param vec A pointer to the vector.
+ * \returns The number of shards or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_sharded_shards(const vec_sharded_t *vec);
+
+/** Get the total number of elements in all the shards. Must only be
+ * called after all appends have finished.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \returns The number of elements or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_sharded_size(const vec_sharded_t *vec, size_t sizeof_type);
+
+/** Get a const reference to a specific member of the merged view, in which
+ * the shards follow each other in order. Must only be called after all
+ * appends have finished.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param index The index of the element in the merged view.
+ * \returns A const pointer to the element or NULL on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+const void *vec_sharded_at_const(const vec_sharded_t *vec, size_t sizeof_type, size_t index);
+
+/** Appends the merged view to a plain vector. Must only be called after
+ * all appends have finished.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param dst A pointer to the destination vector.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_sharded_merge(const vec_sharded_t *vec, size_t sizeof_type, vec_t *dst);
+
+/** Cleans up all the allocated data associated with the vector.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type. */
+void vec_sharded_del(vec_sharded_t *vec, size_t sizeof_type);
+
+#endif
@@ -28,6 +28,7 @@ SOFTWARE.
  * in the vec library. */
 
 #include "vec.h"
+#include "vec_internal.h"
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -53,6 +54,46 @@ static inline void set_err(const char *msg) {
 	sprintf(g_err, "%s %s\n", vec_err_header, msg);
 }
 
+/** Sets the global error string on behalf of the other modules
+ * of the library. */
+void vec_set_err(const char *msg) {
+	set_err(msg);
+}
+
+/** Allocates zeroed memory for count objects of size bytes aligned to
+ * align bytes, which must be a power of two. The pointer returned by
+ * calloc() is stored right before the aligned block. */
+void *vec_aligned_calloc(size_t count, size_t size, size_t align) {
+	if (size && count > (SIZE_MAX - align - sizeof(void*)) / size) {
+		set_err("Requested aligned allocation overflows.");
+		return NULL;
+	}
+
+	uint8_t *raw = calloc(1, count * size + align + sizeof(void*));
+	if (!raw) {
+		set_err("Failed to allocate aligned memory.");
+		return NULL;
+	}
+
+	uintptr_t addr = ((uintptr_t)raw + sizeof(void*) + align - 1) & ~(uintptr_t)(align - 1);
+	void **aligned = (void**)addr;
+	aligned[-1] = raw;
+
+	return aligned;
+}
+
+/** Frees memory allocated by vec_aligned_calloc(). */
+void vec_aligned_free(void *ptr) {
+	if (ptr) {
+		free(((void**)ptr)[-1]);
+	}
+}
+
+/** Returns the capacity the vector grows to when it runs out of space. */
+static inline size_t grown_capacity(size_t capacity) {
+	return capacity + capacity / 2 + 1;
+}
+
 /** Opaque vector type. */
 struct vec {
 
@@ -69,6 +110,38 @@ struct vec {
 	size_t sizeof_vec;
 };
 
+/** Makes sure the vector has room for count more elements, growing it
+ * at least by the usual factor if it doesn't. */
+static inline int reserve(vec_t *vec, size_t sizeof_type, size_t count) {
+	if (count > SIZE_MAX - vec->sizeof_vec) {
+		set_err("Requested size overflows the vector.");
+		return 1;
+	}
+
+	size_t needed = vec->sizeof_vec + count;
+	if (needed <= vec->capacity) {
+		return 0;
+	}
+
+	size_t capacity = grown_capacity(vec->capacity);
+	if (capacity < needed || capacity > SIZE_MAX / sizeof_type) {
+		capacity = needed;
+	}
+	if (capacity > SIZE_MAX / sizeof_type) {
+		set_err("Requested size overflows the vector.");
+		return 1;
+	}
+	uint8_t *tmp = (uint8_t*)realloc(vec->data, capacity * sizeof_type);
+	if (!tmp) {
+		set_err("Failed to expand vector.");
+		return 1;
+	}
+	vec->data = tmp;
+	vec->capacity = capacity;
+
+	return 0;
+}
+
 /** Creates a new vec_t on the heap with the default capacity.
  * \param sizeof_type The size of the desired tpye.
  * \returns A pointer to the allocated vector object or NULL
@@ -101,7 +174,7 @@ vec_t *vec_new_with_capacity(size_t sizeof_type, size_t capacity) {
 		return NULL;
 	}
 
-	vec->capacity = VEC_DEFAULT_CAPACITY;
+	vec->capacity = capacity;
 	vec->sizeof_type = sizeof_type;
 	vec->sizeof_vec = 0;
 
@@ -121,15 +194,15 @@ int vec_push(vec_t *vec, size_t sizeof_type, const void *data) {
 		return 1;
 	}
 
-	if ((vec->sizeof_vec + 1) * sizeof_type > vec->capacity * sizeof_type) {
-		uint8_t *tmp = (uint8_t*)realloc(
-			vec->data, (size_t)((float)vec->capacity * 1.5f) * sizeof_type
-		);
+	if (vec->sizeof_vec + 1 > vec->capacity) {
+		size_t capacity = grown_capacity(vec->capacity);
+		uint8_t *tmp = (uint8_t*)realloc(vec->data, capacity * sizeof_type);
 		if (!tmp) {
 			set_err("Failed to expand vector.");
 			return 1;
 		}
 		vec->data = tmp;
+		vec->capacity = capacity;
 	}
 
 	memcpy(vec->data + vec->sizeof_vec * sizeof_type, data, sizeof_type);
@@ -138,6 +211,90 @@ int vec_push(vec_t *vec, size_t sizeof_type, const void *data) {
 	return 0;
 }
 
+/** Appends a number of contiguous elements at the end of the vector,
+ * reallocating it at most once.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param data A pointer to the first element to be appended. May point
+ * into the vector itself.
+ * \param count The number of elements to be appended.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_append(vec_t *vec, size_t sizeof_type, const void *data, size_t count) {
+	if (!vec || !vec->data || (!data && count) || sizeof_type != vec->sizeof_type) {
+		set_err("Invalid arguments in vec_append().");
+		return 1;
+	}
+
+	/* Data taken from the vector itself has to be found again after
+	 * a reallocation. */
+	uintptr_t begin = (uintptr_t)vec->data;
+	uintptr_t end = begin + vec->sizeof_vec * sizeof_type;
+	int aliased = (uintptr_t)data >= begin && (uintptr_t)data < end;
+	size_t offset = (size_t)((uintptr_t)data - begin);
+
+	if (reserve(vec, sizeof_type, count)) {
+		return 1;
+	}
+
+	if (aliased) {
+		data = vec->data + offset;
+	}
+
+	if (count) {
+		memmove(vec->data + vec->sizeof_vec * sizeof_type, data, count * sizeof_type);
+	}
+	vec->sizeof_vec += count;
+
+	return 0;
+}
+
+/** Makes room for a number of elements at the end of the vector without
+ * adding them, so they can be filled in place, e.g. by a read() call.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param count The number of elements to make room for.
+ * \returns A pointer to the first unused element or NULL on failure.
+ * The pointer is invalidated by any call that reallocates the vector.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+void *vec_reserve(vec_t *vec, size_t sizeof_type, size_t count) {
+	if (!vec || !vec->data || sizeof_type != vec->sizeof_type) {
+		set_err("Invalid arguments in vec_reserve().");
+		return NULL;
+	}
+
+	if (reserve(vec, sizeof_type, count)) {
+		return NULL;
+	}
+
+	return (void*)&vec->data[vec->sizeof_vec * sizeof_type];
+}
+
+/** Adds elements filled in place after vec_reserve() to the vector.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param count The number of elements to add.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_commit(vec_t *vec, size_t sizeof_type, size_t count) {
+	if (!vec || !vec->data || sizeof_type != vec->sizeof_type) {
+		set_err("Invalid arguments in vec_commit().");
+		return 1;
+	}
+
+	if (count > vec->capacity - vec->sizeof_vec) {
+		set_err("Commit exceeds the reserved capacity in vec_commit().");
+		return 1;
+	}
+
+	vec->sizeof_vec += count;
+
+	return 0;
+}
+
 /** Remove the last element of the vector, shrinking it if necessary.
  * \param vec A pointer to the vector.
  * \param sizeof_type The size of the underlying type.
@@ -153,11 +310,13 @@ int vec_pop(vec_t *vec, size_t sizeof_type) {
 	if (vec->sizeof_vec - 1 <= vec->capacity / 2 &&
 		vec->capacity / 2 >= VEC_DEFAULT_CAPACITY
 	) {
-		uint8_t *tmp = (uint8_t*)realloc(vec->data, vec->capacity * sizeof_type / 2);
+		uint8_t *tmp = (uint8_t*)realloc(vec->data, vec->capacity / 2 * sizeof_type);
 		if (!tmp) {
 			set_err("Failed to shrink vector.");
 			return 1;
 		}
+		vec->data = tmp;
+		vec->capacity /= 2;
 	}
 
 	vec->sizeof_vec--;
@@ -223,7 +382,7 @@ int vec_clear(vec_t *vec, size_t sizeof_type) {
 		return 0;
 	}
 
-	uint8_t *tmp = (uint8_t*)realloc(vec->data, VEC_DEFAULT_CAPACITY);
+	uint8_t *tmp = (uint8_t*)realloc(vec->data, VEC_DEFAULT_CAPACITY * sizeof_type);
 	if (!tmp) {
 		set_err("Failed to shrink vector.");
 		return 1;
@@ -263,11 +422,13 @@ int vec_remove(vec_t *vec, size_t sizeof_type, size_t index){
 	if (vec->sizeof_vec - 1 <= vec->capacity / 2 &&
 		vec->capacity / 2 >= VEC_DEFAULT_CAPACITY
 	) {
-		uint8_t *tmp = (uint8_t*)realloc(vec->data, vec->capacity * sizeof_type / 2);
+		uint8_t *tmp = (uint8_t*)realloc(vec->data, vec->capacity / 2 * sizeof_type);
 		if (!tmp) {
 			set_err("Failed to shrink vector.");
 			return 1;
 		}
+		vec->data = tmp;
+		vec->capacity /= 2;
 	}
 
 	vec->sizeof_vec--;
@@ -295,15 +456,14 @@ int vec_insert(vec_t *vec, size_t sizeof_type, size_t index, const void *data) {
 	}
 
 	if (vec->sizeof_vec + 1 > vec->capacity) {
-		uint8_t *tmp = (uint8_t*)realloc(
-			vec->data, (size_t)((float)vec->capacity * 1.5) * sizeof_type
-		);
+		size_t capacity = grown_capacity(vec->capacity);
+		uint8_t *tmp = (uint8_t*)realloc(vec->data, capacity * sizeof_type);
 		if (!tmp) {
 			set_err("Failed to expand vector.");
 			return 1;
 		}
 		vec->data = tmp;
-		vec->capacity = (size_t)((float)vec->capacity * 1.5);
+		vec->capacity = capacity;
 	}
 
 	memmove(
@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/vec_internal.h
+ * \brief Private header file for the vec library.
+ * \details This file contains the declarations shared between the
+ * translation units of the library that are not part of the public api. */
+
+#ifndef VEC_INTERNAL_H
+#define VEC_INTERNAL_H
+
+#include <stddef.h>
+
+/** Sets the global error string on behalf of the other modules
+ * of the library. */
+void vec_set_err(const char *msg);
+
+/** The assumed size of a cache line, used to keep data written by
+ * different threads on separate lines. */
+#define VEC_CACHE_LINE 64LU
+
+/** Allocates zeroed memory for count objects of size bytes aligned to
+ * align bytes, which must be a power of two. Sets the global error string
+ * and returns NULL on failure. The memory must be released with
+ * vec_aligned_free(). */
+void *vec_aligned_calloc(size_t count, size_t size, size_t align);
+
+/** Frees memory allocated by vec_aligned_calloc(). */
+void vec_aligned_free(void *ptr);
+
+#endif
@@ -0,0 +1,543 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/vec_io.c
+ * \brief Implementation file for streaming vectors from and to files.
+ * \details This file contains the implementation of all the functions
+ * declared in vec_io.h. The io_uring backend talks to the kernel through
+ * the raw system calls so the library doesn't depend on liburing. */
+
+#include "vec_io.h"
+#include "vec_internal.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <stdio.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+/** The largest number of bytes passed to a single read() or write(). */
+#define VEC_IO_MAX_CHUNK ((size_t)INT_MAX)
+
+/** The largest number of reads kept in flight by vec_io_read_at(). */
+#define VEC_IO_MAX_DEPTH 256LU
+
+/** The smallest number of bytes worth a separate io_uring read. Setting up
+ * a ring costs a few system calls and mappings, so reads too short to
+ * split into at least two such chunks go through pread() instead. */
+#define VEC_IO_URING_MIN_CHUNK (128LU * 1024LU)
+
+/** Reads at most len bytes at the current file position. */
+static int64_t sys_read(int fd, void *buf, size_t len) {
+	if (len > VEC_IO_MAX_CHUNK) len = VEC_IO_MAX_CHUNK;
+#ifdef _WIN32
+	return _read(fd, buf, (unsigned)len);
+#else
+	return read(fd, buf, len);
+#endif
+}
+
+/** Gets the number of bytes after offset in a regular file.
+ * \returns 0 on success or 1 if fd is not a regular file or its size
+ * can't be queried. */
+static int regular_file_remaining(int fd, uint64_t offset, uint64_t *remaining) {
+#ifdef _WIN32
+	struct _stat64 st;
+	if (_fstat64(fd, &st) || !(st.st_mode & _S_IFREG)) return 1;
+#else
+	struct stat st;
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode)) return 1;
+#endif
+	uint64_t size = st.st_size > 0 ? (uint64_t)st.st_size : 0;
+	*remaining = offset < size ? size - offset : 0;
+	return 0;
+}
+
+/** Waits until a non-blocking descriptor has data to read.
+ * \returns 0 on success or 1 on failure. */
+static int wait_readable(int fd) {
+#ifdef _WIN32
+	(void)fd;
+	return 0;
+#else
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	for (;;) {
+		int ret = poll(&pfd, 1, -1);
+		if (ret < 0 && errno == EINTR) continue;
+		return ret < 0;
+	}
+#endif
+}
+
+/** Reads at most len bytes at a byte offset. On Windows this moves the
+ * file position. */
+static int64_t sys_pread(int fd, void *buf, size_t len, uint64_t offset) {
+	if (len > VEC_IO_MAX_CHUNK) len = VEC_IO_MAX_CHUNK;
+#ifdef _WIN32
+	if (_lseeki64(fd, (__int64)offset, SEEK_SET) < 0) return -1;
+	return _read(fd, buf, (unsigned)len);
+#else
+	return pread(fd, buf, len, (off_t)offset);
+#endif
+}
+
+/** Writes at most len bytes at the current file position. */
+static int64_t sys_write(int fd, const void *buf, size_t len) {
+	if (len > VEC_IO_MAX_CHUNK) len = VEC_IO_MAX_CHUNK;
+#ifdef _WIN32
+	return _write(fd, buf, (unsigned)len);
+#else
+	return write(fd, buf, len);
+#endif
+}
+
+/** Reads len bytes at a byte offset one read at a time, stopping early
+ * only at the end of the file.
+ * \returns The number of bytes read or (size_t)-1 on failure. */
+static size_t pread_all(int fd, uint8_t *buf, size_t len, uint64_t offset) {
+	size_t done = 0;
+	while (done < len) {
+		int64_t n = sys_pread(fd, buf + done, len - done, offset + done);
+		if (n < 0 && errno == EINTR) continue;
+		if (n < 0) {
+			vec_set_err("Failed to read file in vec_io_read_at().");
+			return (size_t)-1;
+		}
+		if (n == 0) break;
+		done += (size_t)n;
+	}
+	return done;
+}
+
+#ifdef __linux__
+
+/** The outcome of uring_read(). */
+enum uring_status {
+	URING_OK,
+	URING_FAILED,
+	URING_UNAVAILABLE
+};
+
+/** The mapped rings of an io_uring instance. */
+struct uring {
+	int fd;
+	unsigned *sq_tail;
+	unsigned *sq_mask;
+	unsigned *sq_array;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned *cq_mask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	void *sq_ptr;
+	void *cq_ptr;
+	size_t sq_len;
+	size_t cq_len;
+	size_t sqes_len;
+};
+
+/** A part of the file read by a single request. */
+struct uring_chunk {
+
+	/** The offset of the chunk relative to the start of the read. */
+	size_t offset;
+
+	/** The length of the chunk in bytes. */
+	size_t len;
+
+	/** The number of bytes read so far. */
+	size_t done;
+
+	/** Set once the chunk is read in full or the end of the file is hit. */
+	int finished;
+};
+
+static void uring_del(struct uring *ring) {
+	if (ring->sqes) munmap(ring->sqes, ring->sqes_len);
+	if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr) munmap(ring->cq_ptr, ring->cq_len);
+	if (ring->sq_ptr) munmap(ring->sq_ptr, ring->sq_len);
+	close(ring->fd);
+}
+
+static int uring_init(struct uring *ring, unsigned entries) {
+	struct io_uring_params p = {0};
+	*ring = (struct uring){0};
+
+	ring->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+	if (ring->fd < 0) {
+		return 1;
+	}
+
+	ring->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	ring->cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->cq_len > ring->sq_len) ring->sq_len = ring->cq_len;
+		ring->cq_len = ring->sq_len;
+	}
+	ring->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+
+	ring->sq_ptr = mmap(NULL, ring->sq_len, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	if (ring->sq_ptr == MAP_FAILED) {
+		ring->sq_ptr = NULL;
+		uring_del(ring);
+		return 1;
+	}
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->cq_ptr = ring->sq_ptr;
+	} else {
+		ring->cq_ptr = mmap(NULL, ring->cq_len, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+		if (ring->cq_ptr == MAP_FAILED) {
+			ring->cq_ptr = NULL;
+			uring_del(ring);
+			return 1;
+		}
+	}
+
+	ring->sqes = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED) {
+		ring->sqes = NULL;
+		uring_del(ring);
+		return 1;
+	}
+
+	uint8_t *sq = ring->sq_ptr;
+	uint8_t *cq = ring->cq_ptr;
+	ring->sq_tail = (unsigned*)(sq + p.sq_off.tail);
+	ring->sq_mask = (unsigned*)(sq + p.sq_off.ring_mask);
+	ring->sq_array = (unsigned*)(sq + p.sq_off.array);
+	ring->cq_head = (unsigned*)(cq + p.cq_off.head);
+	ring->cq_tail = (unsigned*)(cq + p.cq_off.tail);
+	ring->cq_mask = (unsigned*)(cq + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+
+	return 0;
+}
+
+/** Queues a read of the unread part of a chunk. */
+static void uring_queue_read(
+	struct uring *ring, int fd, uint8_t *buf, uint64_t offset,
+	const struct uring_chunk *chunk, size_t index
+) {
+	unsigned tail = *ring->sq_tail;
+	unsigned slot = tail & *ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[slot];
+	size_t len = chunk->len - chunk->done;
+
+	*sqe = (struct io_uring_sqe){0};
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = fd;
+	sqe->addr = (uint64_t)(uintptr_t)(buf + chunk->offset + chunk->done);
+	sqe->len = (uint32_t)(len > VEC_IO_MAX_CHUNK ? VEC_IO_MAX_CHUNK : len);
+	sqe->off = offset + chunk->offset + chunk->done;
+	sqe->user_data = index;
+
+	ring->sq_array[slot] = slot;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/** Reads len bytes at a byte offset split into chunks read concurrently.
+ * \param read Set to the number of contiguous bytes read from the start. */
+static enum uring_status uring_read(
+	int fd, uint8_t *buf, size_t len, uint64_t offset, size_t depth, size_t *read
+) {
+	size_t chunk_len = (len + depth - 1) / depth;
+	size_t chunks_len = (len + chunk_len - 1) / chunk_len;
+
+	struct uring ring;
+	if (uring_init(&ring, (unsigned)chunks_len)) {
+		return URING_UNAVAILABLE;
+	}
+
+	struct uring_chunk *chunks = calloc(chunks_len, sizeof(struct uring_chunk));
+	if (!chunks) {
+		vec_set_err("Failed to allocate io_uring chunks in vec_io_read_at().");
+		uring_del(&ring);
+		return URING_FAILED;
+	}
+
+	for (size_t i = 0; i < chunks_len; i++) {
+		chunks[i].offset = i * chunk_len;
+		chunks[i].len = i + 1 < chunks_len ? chunk_len : len - i * chunk_len;
+		uring_queue_read(&ring, fd, buf, offset, &chunks[i], i);
+	}
+
+	enum uring_status status = URING_OK;
+	size_t queued = chunks_len;
+	size_t in_flight = 0;
+
+	while (queued || in_flight) {
+		long ret = syscall(__NR_io_uring_enter, ring.fd, (unsigned)queued,
+			1U, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (ret < 0 && errno == EINTR) continue;
+		if (ret < 0) {
+			/* Nothing was submitted, so no read still targets buf. */
+			if (!in_flight) {
+				status = URING_UNAVAILABLE;
+				break;
+			}
+			vec_set_err("Failed to submit io_uring reads in vec_io_read_at().");
+			status = URING_FAILED;
+			queued = 0;
+		}
+		in_flight += (size_t)ret < queued ? (size_t)ret : queued;
+		queued -= (size_t)ret < queued ? (size_t)ret : queued;
+
+		unsigned head = *ring.cq_head;
+		unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++) {
+			const struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cq_mask];
+			struct uring_chunk *chunk = &chunks[cqe->user_data];
+			in_flight--;
+
+			if (cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP) {
+				/* Kernels that predate IORING_OP_READ reject it here. */
+				if (status == URING_OK) status = URING_UNAVAILABLE;
+			} else if (cqe->res < 0 && cqe->res != -EINTR && cqe->res != -EAGAIN) {
+				vec_set_err("Failed to read file in vec_io_read_at().");
+				status = URING_FAILED;
+			}
+			if (cqe->res == 0) {
+				chunk->finished = 1;
+			} else if (cqe->res > 0) {
+				chunk->done += (size_t)cqe->res;
+				chunk->finished = chunk->done == chunk->len;
+			}
+			if (!chunk->finished && status == URING_OK) {
+				uring_queue_read(&ring, fd, buf, offset, chunk, cqe->user_data);
+				queued++;
+			}
+		}
+		__atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+	}
+
+	*read = 0;
+	for (size_t i = 0; i < chunks_len; i++) {
+		*read += chunks[i].done;
+		if (chunks[i].done < chunks[i].len) break;
+	}
+
+	free(chunks);
+	uring_del(&ring);
+
+	return status;
+}
+
+#endif
+
+/** Reads up to count elements from a file descriptor, such as a pipe or
+ * a socket, and appends them to the vector. On a blocking descriptor it
+ * waits until at least one element is available. Once part of an element
+ * has been read, it waits for the rest even on a non-blocking descriptor,
+ * so the stream never loses its element alignment.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param fd The file descriptor to read from.
+ * \param count The maximum number of elements to read.
+ * \returns The number of elements appended, 0 at the end of the file,
+ * VEC_IO_WOULD_BLOCK if a non-blocking descriptor had no data or
+ * (size_t)-1 on failure. A partial element at the end of the file is not
+ * appended. On failure, the whole elements read before the error are
+ * still appended.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_io_read(vec_t *vec, size_t sizeof_type, int fd, size_t count) {
+	if (!vec || fd < 0 || !sizeof_type) {
+		vec_set_err("Invalid arguments in vec_io_read().");
+		return (size_t)-1;
+	}
+
+	if (count > SIZE_MAX / sizeof_type) {
+		count = SIZE_MAX / sizeof_type;
+	}
+
+	uint8_t *spare = vec_reserve(vec, sizeof_type, count);
+	if (!spare) {
+		return (size_t)-1;
+	}
+
+	size_t len = count * sizeof_type;
+	size_t done = 0;
+	int failed = 0;
+	int would_block = 0;
+	while (done < len) {
+		int64_t n = sys_read(fd, spare + done, len - done);
+		if (n < 0 && errno == EINTR) continue;
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			if (done % sizeof_type == 0) {
+				would_block = 1;
+				break;
+			}
+			if (wait_readable(fd)) {
+				failed = 1;
+				break;
+			}
+			continue;
+		}
+		if (n < 0) {
+			failed = 1;
+			break;
+		}
+		if (n == 0) break;
+		done += (size_t)n;
+		if (done % sizeof_type == 0) break;
+	}
+
+	if (vec_commit(vec, sizeof_type, done / sizeof_type)) {
+		return (size_t)-1;
+	}
+
+	if (failed) {
+		vec_set_err("Failed to read file in vec_io_read().");
+		return (size_t)-1;
+	}
+
+	if (would_block && !done) {
+		return VEC_IO_WOULD_BLOCK;
+	}
+
+	return done / sizeof_type;
+}
+
+/** Reads up to count elements from a file starting at a byte offset and
+ * appends them to the vector, keeping up to depth reads in flight. For
+ * regular files, count is first limited to the elements the file holds
+ * after offset, so a generous count doesn't reserve unused capacity. The
+ * file position is not used or changed, except on Windows, which lacks a
+ * positional read and moves it.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param fd The file descriptor of a regular file to read from.
+ * \param offset The byte offset to start reading at.
+ * \param count The maximum number of elements to read.
+ * \param depth The maximum number of concurrent reads.
+ * \returns The number of elements appended, which is less than count only
+ * if the end of the file was reached, or (size_t)-1 on failure. A partial
+ * element at the end of the file is not appended.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_io_read_at(vec_t *vec, size_t sizeof_type, int fd, uint64_t offset, size_t count, size_t depth) {
+	if (!vec || fd < 0 || !sizeof_type || !depth) {
+		vec_set_err("Invalid arguments in vec_io_read_at().");
+		return (size_t)-1;
+	}
+
+	if (count > SIZE_MAX / sizeof_type) {
+		count = SIZE_MAX / sizeof_type;
+	}
+
+	uint64_t available;
+	if (!regular_file_remaining(fd, offset, &available) &&
+		count > available / sizeof_type
+	) {
+		count = (size_t)(available / sizeof_type);
+	}
+
+	uint8_t *spare = vec_reserve(vec, sizeof_type, count);
+	if (!spare) {
+		return (size_t)-1;
+	}
+
+	size_t len = count * sizeof_type;
+	size_t done = (size_t)-1;
+
+#ifdef __linux__
+	if (depth > len / VEC_IO_URING_MIN_CHUNK) depth = len / VEC_IO_URING_MIN_CHUNK;
+	if (depth > VEC_IO_MAX_DEPTH) depth = VEC_IO_MAX_DEPTH;
+	if (depth > 1) {
+		switch (uring_read(fd, spare, len, offset, depth, &done)) {
+			case URING_OK:
+				break;
+			case URING_FAILED:
+				return (size_t)-1;
+			case URING_UNAVAILABLE:
+				done = (size_t)-1;
+				break;
+		}
+	}
+#endif
+
+	if (done == (size_t)-1) {
+		done = pread_all(fd, spare, len, offset);
+		if (done == (size_t)-1) {
+			return (size_t)-1;
+		}
+	}
+
+	if (vec_commit(vec, sizeof_type, done / sizeof_type)) {
+		return (size_t)-1;
+	}
+
+	return done / sizeof_type;
+}
+
+/** Writes all the elements of the vector to a file descriptor.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param fd The file descriptor to write to.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_io_write(const vec_t *vec, size_t sizeof_type, int fd) {
+	size_t size = vec_size(vec, sizeof_type);
+	if (size == (size_t)-1 || fd < 0) {
+		vec_set_err("Invalid arguments in vec_io_write().");
+		return 1;
+	}
+
+	if (!size) {
+		return 0;
+	}
+
+	const uint8_t *data = vec_at_const(vec, sizeof_type, 0);
+	size_t len = size * sizeof_type;
+	size_t done = 0;
+	while (done < len) {
+		int64_t n = sys_write(fd, data + done, len - done);
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) {
+			vec_set_err("Failed to write file in vec_io_write().");
+			return 1;
+		}
+		done += (size_t)n;
+	}
+
+	return 0;
+}
@@ -0,0 +1,393 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/vec_packed.c
+ * \brief Implementation file for the compressed integer vector.
+ * \details This file contains the implementation of all the functions
+ * declared in vec_packed.h. No SIMD intrinsics are used. Decoding
+ * relies on auto-vectorization of the unpacking pass over a fixed size
+ * frame, which gcc performs at -O3 -march=native, while the prefix sum
+ * pass that follows is serial. */
+
+#include "vec_packed.h"
+#include "vec_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define VEC_PACKED_DEFAULT_FRAMES 8LU
+
+/** Metadata of a compressed frame. */
+struct vec_packed_frame {
+
+	/** The first value of the frame. */
+	int64_t base;
+
+	/** The index of the first word of the frame. */
+	size_t offset;
+
+	/** The number of bits per delta. A frame takes 2 * width words. */
+	unsigned width;
+};
+
+/** Opaque compressed integer vector type. */
+struct vec_packed {
+
+	/** The bit-packed deltas of all the frames followed by
+	 * a zeroed padding word. */
+	uint64_t *words;
+
+	/** The number of words in use, excluding the padding word. */
+	size_t words_len;
+
+	/** The number of allocated words. */
+	size_t words_cap;
+
+	/** The metadata of the compressed frames. */
+	struct vec_packed_frame *frames;
+
+	/** The number of compressed frames. */
+	size_t frames_len;
+
+	/** The number of allocated frame slots. */
+	size_t frames_cap;
+
+	/** The values not yet compressed into a frame. */
+	int64_t tail[VEC_PACKED_FRAME];
+
+	/** The number of values in tail. */
+	size_t tail_len;
+};
+
+/** Maps signed deltas to unsigned ones so small negative deltas
+ * need few bits too. */
+static inline uint64_t zigzag(uint64_t delta) {
+	return (delta << 1) ^ (uint64_t)((int64_t)delta >> 63);
+}
+
+/** Inverse of zigzag(). */
+static inline uint64_t unzigzag(uint64_t value) {
+	return (value >> 1) ^ (0 - (value & 1));
+}
+
+/** Returns the mask of the lowest width bits. */
+static inline uint64_t width_mask(unsigned width) {
+	return width == 64 ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+}
+
+/** Extracts the index-th value of a frame. Reading one word past the
+ * frame is safe thanks to the padding word. */
+static inline uint64_t unpack_one(const uint64_t *words, unsigned width, size_t index) {
+	size_t bit = index * width;
+	size_t word = bit >> 6;
+	unsigned shift = (unsigned)(bit & 63);
+	uint64_t lo = words[word] >> shift;
+	uint64_t hi = (words[word + 1] << 1) << (63 - shift);
+	return (lo | hi) & width_mask(width);
+}
+
+/** Decodes a compressed frame into VEC_PACKED_FRAME values. */
+static void decode_frame(
+	const vec_packed_t *vec, const struct vec_packed_frame *frame, int64_t *values
+) {
+	uint64_t deltas[VEC_PACKED_FRAME] = {0};
+	const uint64_t *words = vec->words + frame->offset;
+
+	if (frame->width) {
+		for (size_t i = 0; i < VEC_PACKED_FRAME; i++) {
+			deltas[i] = unzigzag(unpack_one(words, frame->width, i));
+		}
+	}
+
+	uint64_t acc = (uint64_t)frame->base;
+	for (size_t i = 0; i < VEC_PACKED_FRAME; i++) {
+		acc += deltas[i];
+		values[i] = (int64_t)acc;
+	}
+}
+
+/** Compresses the full tail into a new frame. */
+static int pack_tail(vec_packed_t *vec) {
+	uint64_t deltas[VEC_PACKED_FRAME];
+	uint64_t bits = 0;
+
+	deltas[0] = 0;
+	for (size_t i = 1; i < VEC_PACKED_FRAME; i++) {
+		deltas[i] = zigzag((uint64_t)vec->tail[i] - (uint64_t)vec->tail[i - 1]);
+		bits |= deltas[i];
+	}
+
+	unsigned width = 0;
+	while (width < 64 && bits >> width) {
+		width++;
+	}
+
+	if (vec->frames_len == vec->frames_cap) {
+		size_t frames_cap = vec->frames_cap * 2;
+		struct vec_packed_frame *tmp = (struct vec_packed_frame*)realloc(
+			vec->frames, frames_cap * sizeof(struct vec_packed_frame)
+		);
+		if (!tmp) {
+			vec_set_err("Failed to expand vec_packed frames.");
+			return 1;
+		}
+		vec->frames = tmp;
+		vec->frames_cap = frames_cap;
+	}
+
+	size_t frame_words = 2 * (size_t)width;
+	if (vec->words_len + frame_words + 1 > vec->words_cap) {
+		size_t words_cap = vec->words_cap + vec->words_cap / 2;
+		if (words_cap < vec->words_len + frame_words + 1) {
+			words_cap = vec->words_len + frame_words + 1;
+		}
+		uint64_t *tmp = (uint64_t*)realloc(vec->words, words_cap * sizeof(uint64_t));
+		if (!tmp) {
+			vec_set_err("Failed to expand vec_packed words.");
+			return 1;
+		}
+		memset(
+			tmp + vec->words_cap, 0,
+			(words_cap - vec->words_cap) * sizeof(uint64_t)
+		);
+		vec->words = tmp;
+		vec->words_cap = words_cap;
+	}
+
+	uint64_t *words = vec->words + vec->words_len;
+	for (size_t i = 0; width && i < VEC_PACKED_FRAME; i++) {
+		size_t bit = i * width;
+		size_t word = bit >> 6;
+		unsigned shift = (unsigned)(bit & 63);
+		words[word] |= deltas[i] << shift;
+		if (shift + width > 64) {
+			words[word + 1] |= deltas[i] >> (64 - shift);
+		}
+	}
+
+	struct vec_packed_frame *frame = &vec->frames[vec->frames_len];
+	frame->base = vec->tail[0];
+	frame->offset = vec->words_len;
+	frame->width = width;
+
+	vec->frames_len++;
+	vec->words_len += frame_words;
+	vec->tail_len = 0;
+
+	return 0;
+}
+
+/** Converts decoded values to a signed integer type narrower than
+ * 8 bytes. */
+static void narrow(void *dst, const int64_t *src, size_t count, size_t sizeof_type) {
+	switch (sizeof_type) {
+		case 1:
+			for (size_t i = 0; i < count; i++) ((int8_t*)dst)[i] = (int8_t)src[i];
+			break;
+		case 2:
+			for (size_t i = 0; i < count; i++) ((int16_t*)dst)[i] = (int16_t)src[i];
+			break;
+		case 4:
+			for (size_t i = 0; i < count; i++) ((int32_t*)dst)[i] = (int32_t)src[i];
+			break;
+	}
+}
+
+/** Creates a new, empty vec_packed_t on the heap.
+ * \returns A pointer to the allocated vector object or NULL
+ * on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+vec_packed_t *vec_packed_new(void) {
+	vec_packed_t *vec = calloc(1, sizeof(vec_packed_t));
+	if (!vec) {
+		vec_set_err("Failed to allocate vec_packed_t.");
+		return NULL;
+	}
+
+	vec->frames = calloc(VEC_PACKED_DEFAULT_FRAMES, sizeof(struct vec_packed_frame));
+	if (!vec->frames) {
+		vec_set_err("Failed to allocate vec_packed->frames.");
+		free(vec);
+		return NULL;
+	}
+
+	vec->words = calloc(1, sizeof(uint64_t));
+	if (!vec->words) {
+		vec_set_err("Failed to allocate vec_packed->words.");
+		free(vec->frames);
+		free(vec);
+		return NULL;
+	}
+
+	vec->frames_cap = VEC_PACKED_DEFAULT_FRAMES;
+	vec->words_cap = 1;
+
+	return vec;
+}
+
+/** Appends a value at the end of the vector. Every VEC_PACKED_FRAME-th
+ * push compresses the pending values into a new frame.
+ * \param vec A pointer to the vector.
+ * \param value The value to be appended.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_packed_push(vec_packed_t *vec, int64_t value) {
+	if (!vec || !vec->words || !vec->frames) {
+		vec_set_err("Invalid arguments in vec_packed_push().");
+		return 1;
+	}
+
+	vec->tail[vec->tail_len++] = value;
+	if (vec->tail_len == VEC_PACKED_FRAME && pack_tail(vec)) {
+		vec->tail_len--;
+		return 1;
+	}
+
+	return 0;
+}
+
+/** Get a copy of a specific member of the vector. Only the frame holding
+ * the element is decoded.
+ * \param vec A pointer to the vector.
+ * \param index The index of the element.
+ * \param value A pointer to the location the value is copied to.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_packed_at(const vec_packed_t *vec, size_t index, int64_t *value) {
+	if (!vec || !vec->words || !vec->frames || !value) {
+		vec_set_err("Invalid arguments in vec_packed_at().");
+		return 1;
+	}
+
+	size_t frame_index = index / VEC_PACKED_FRAME;
+	size_t pos = index % VEC_PACKED_FRAME;
+
+	if (frame_index == vec->frames_len && pos < vec->tail_len) {
+		*value = vec->tail[pos];
+		return 0;
+	}
+
+	if (frame_index >= vec->frames_len) {
+		vec_set_err("Out of bounds index passed to vec_packed_at().");
+		return 1;
+	}
+
+	const struct vec_packed_frame *frame = &vec->frames[frame_index];
+	const uint64_t *words = vec->words + frame->offset;
+	uint64_t acc = (uint64_t)frame->base;
+	for (size_t i = 1; frame->width && i <= pos; i++) {
+		acc += unzigzag(unpack_one(words, frame->width, i));
+	}
+	*value = (int64_t)acc;
+
+	return 0;
+}
+
+/** Get the number of elements in the vector.
+ * \param vec A pointer to the vector.
+ * \returns The number of elements or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_packed_size(const vec_packed_t *vec) {
+	if (!vec || !vec->words || !vec->frames) {
+		vec_set_err("Invalid arguments in vec_packed_size().");
+		return (size_t)-1;
+	}
+
+	return vec->frames_len * VEC_PACKED_FRAME + vec->tail_len;
+}
+
+/** Get the number of bytes used to store the elements of the vector.
+ * \param vec A pointer to the vector.
+ * \returns The number of bytes or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_packed_bytes(const vec_packed_t *vec) {
+	if (!vec || !vec->words || !vec->frames) {
+		vec_set_err("Invalid arguments in vec_packed_bytes().");
+		return (size_t)-1;
+	}
+
+	return sizeof(vec_packed_t) +
+		vec->words_cap * sizeof(uint64_t) +
+		vec->frames_cap * sizeof(struct vec_packed_frame);
+}
+
+/** Decodes every element of the vector and appends them to a plain vector
+ * of signed integers. Values that do not fit the destination type are
+ * truncated.
+ * \param vec A pointer to the vector.
+ * \param dst A pointer to the destination vector.
+ * \param sizeof_type The size of the underlying type of dst. Must be
+ * 1, 2, 4 or 8.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_packed_decode(const vec_packed_t *vec, vec_t *dst, size_t sizeof_type) {
+	if (!vec || !vec->words || !vec->frames || !dst ||
+		(sizeof_type != 1 && sizeof_type != 2 &&
+		 sizeof_type != 4 && sizeof_type != 8)
+	) {
+		vec_set_err("Invalid arguments in vec_packed_decode().");
+		return 1;
+	}
+
+	int64_t values[VEC_PACKED_FRAME];
+	int64_t narrowed[VEC_PACKED_FRAME];
+
+	for (size_t i = 0; i < vec->frames_len; i++) {
+		decode_frame(vec, &vec->frames[i], values);
+		const void *src = values;
+		if (sizeof_type != sizeof(int64_t)) {
+			narrow(narrowed, values, VEC_PACKED_FRAME, sizeof_type);
+			src = narrowed;
+		}
+		if (vec_append(dst, sizeof_type, src, VEC_PACKED_FRAME)) {
+			return 1;
+		}
+	}
+
+	const void *src = vec->tail;
+	if (sizeof_type != sizeof(int64_t)) {
+		narrow(narrowed, vec->tail, vec->tail_len, sizeof_type);
+		src = narrowed;
+	}
+	if (vec_append(dst, sizeof_type, src, vec->tail_len)) {
+		return 1;
+	}
+
+	return 0;
+}
+
+/** Cleans up all the allocated data associated with the vector.
+ * \param vec A pointer to the vector. */
+void vec_packed_del(vec_packed_t *vec) {
+	if (vec) {
+		free(vec->words);
+		free(vec->frames);
+		free(vec);
+	}
+}
@@ -0,0 +1,325 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/vec_rcu.c
+ * \brief Implementation file for the snapshot-readable vector.
+ * \details This file contains the implementation of all the functions
+ * declared in vec_rcu.h. Replaced buffers are reclaimed with epochs:
+ * each active reader publishes the global epoch it started in, growth
+ * tags the replaced buffer with the epoch it was retired in and then
+ * advances the global epoch, and a buffer is freed once every active
+ * reader started in a later epoch than the one it was retired in. All
+ * the atomic operations involved are sequentially consistent, which is
+ * what makes a reader that has loaded an old epoch but not published it
+ * yet safe: it can only load the buffer after the writer's scan missed
+ * it, by which point the new buffer is already published. */
+
+#include "vec_rcu.h"
+#include "vec_internal.h"
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** A buffer holding the elements of the vector. */
+struct vec_rcu_buf {
+
+	/** The number of elements readable in this buffer. */
+	atomic_size_t size;
+
+	/** The maximum number of elements. */
+	size_t capacity;
+
+	/** The epoch the buffer was retired in. */
+	uint64_t retired_epoch;
+
+	/** The next buffer in the list of retired buffers. */
+	struct vec_rcu_buf *next;
+
+	/** The elements. */
+	alignas(max_align_t) uint8_t data[];
+};
+
+/** A reader slot taking a whole cache line of the aligned slot array so
+ * readers don't invalidate each other's cache lines. */
+struct vec_rcu_reader {
+
+	/** The epoch the reader started in or 0 if it is not reading. */
+	atomic_uint_least64_t epoch;
+
+	/** Padding up to VEC_CACHE_LINE. */
+	uint8_t pad[VEC_CACHE_LINE - sizeof(atomic_uint_least64_t)];
+};
+
+/** Opaque snapshot-readable vector type. */
+struct vec_rcu {
+
+	/** The current buffer. */
+	_Atomic(struct vec_rcu_buf *) buf;
+
+	/** The global epoch. */
+	atomic_uint_least64_t epoch;
+
+	/** The reader slots. */
+	struct vec_rcu_reader *readers;
+
+	/** The number of reader slots. */
+	size_t readers_len;
+
+	/** The replaced buffers not freed yet. Only accessed by the writer. */
+	struct vec_rcu_buf *retired;
+
+	/** The size of the underlying type. */
+	size_t sizeof_type;
+};
+
+/** Allocates a buffer for capacity elements. */
+static struct vec_rcu_buf *buf_new(size_t sizeof_type, size_t capacity) {
+	if (capacity > (SIZE_MAX - sizeof(struct vec_rcu_buf)) / sizeof_type) {
+		vec_set_err("Requested capacity overflows the vec_rcu buffer.");
+		return NULL;
+	}
+
+	struct vec_rcu_buf *buf = malloc(sizeof(struct vec_rcu_buf) + capacity * sizeof_type);
+	if (!buf) {
+		vec_set_err("Failed to allocate vec_rcu buffer.");
+		return NULL;
+	}
+
+	atomic_init(&buf->size, 0);
+	buf->capacity = capacity;
+	buf->retired_epoch = 0;
+	buf->next = NULL;
+
+	return buf;
+}
+
+/** Creates a new vec_rcu_t on the heap with the specified capacity.
+ * \param sizeof_type The size of the underlying type.
+ * \param capacity The desired capacity expressed by the number of elements
+ * and not bytes.
+ * \param readers The number of reader slots.
+ * \returns A pointer to the allocated vector object or NULL
+ * on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+vec_rcu_t *vec_rcu_new(size_t sizeof_type, size_t capacity, size_t readers) {
+	if (!sizeof_type || !readers) {
+		vec_set_err("Invalid arguments in vec_rcu_new().");
+		return NULL;
+	}
+
+	vec_rcu_t *vec = calloc(1, sizeof(vec_rcu_t));
+	if (!vec) {
+		vec_set_err("Failed to allocate vec_rcu_t.");
+		return NULL;
+	}
+
+	vec->readers = vec_aligned_calloc(readers, sizeof(struct vec_rcu_reader), VEC_CACHE_LINE);
+	if (!vec->readers) {
+		free(vec);
+		return NULL;
+	}
+
+	struct vec_rcu_buf *buf = buf_new(sizeof_type, capacity);
+	if (!buf) {
+		vec_aligned_free(vec->readers);
+		free(vec);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < readers; i++) {
+		atomic_init(&vec->readers[i].epoch, 0);
+	}
+	atomic_init(&vec->buf, buf);
+	atomic_init(&vec->epoch, 1);
+	vec->readers_len = readers;
+	vec->retired = NULL;
+	vec->sizeof_type = sizeof_type;
+
+	return vec;
+}
+
+/** Frees the buffers replaced by growth that no reader can see anymore.
+ * Growth already does this, so calling it is only needed to release
+ * memory sooner. Must only be called by the writer thread.
+ * \param vec A pointer to the vector.
+ * \returns The number of replaced buffers still in use by readers or
+ * (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_rcu_reclaim(vec_rcu_t *vec) {
+	if (!vec || !vec->readers) {
+		vec_set_err("Invalid arguments in vec_rcu_reclaim().");
+		return (size_t)-1;
+	}
+
+	if (!vec->retired) {
+		return 0;
+	}
+
+	uint64_t oldest = UINT64_MAX;
+	for (size_t i = 0; i < vec->readers_len; i++) {
+		uint64_t epoch = atomic_load(&vec->readers[i].epoch);
+		if (epoch && epoch < oldest) {
+			oldest = epoch;
+		}
+	}
+
+	size_t pending = 0;
+	struct vec_rcu_buf **link = &vec->retired;
+	while (*link) {
+		struct vec_rcu_buf *buf = *link;
+		if (buf->retired_epoch < oldest) {
+			*link = buf->next;
+			free(buf);
+		} else {
+			link = &buf->next;
+			pending++;
+		}
+	}
+
+	return pending;
+}
+
+/** Appends an element at the end of the vector, moving it to a larger
+ * buffer if necessary. Must only be called by the writer thread.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param data A pointer to the data to be appended.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_rcu_push(vec_rcu_t *vec, size_t sizeof_type, const void *data) {
+	if (!vec || !vec->readers || !data || sizeof_type != vec->sizeof_type) {
+		vec_set_err("Invalid arguments in vec_rcu_push().");
+		return 1;
+	}
+
+	struct vec_rcu_buf *buf = atomic_load_explicit(&vec->buf, memory_order_relaxed);
+	size_t size = atomic_load_explicit(&buf->size, memory_order_relaxed);
+
+	if (size == buf->capacity) {
+		if (buf->capacity > SIZE_MAX - buf->capacity / 2 - 1) {
+			vec_set_err("Requested capacity overflows the vec_rcu buffer.");
+			return 1;
+		}
+		struct vec_rcu_buf *grown = buf_new(sizeof_type, buf->capacity + buf->capacity / 2 + 1);
+		if (!grown) {
+			return 1;
+		}
+		memcpy(grown->data, buf->data, size * sizeof_type);
+		atomic_init(&grown->size, size);
+
+		atomic_store(&vec->buf, grown);
+		buf->retired_epoch = atomic_fetch_add(&vec->epoch, 1);
+		buf->next = vec->retired;
+		vec->retired = buf;
+		vec_rcu_reclaim(vec);
+
+		buf = grown;
+	}
+
+	memcpy(buf->data + size * sizeof_type, data, sizeof_type);
+	atomic_store_explicit(&buf->size, size + 1, memory_order_release);
+
+	return 0;
+}
+
+/** Get the number of elements in the vector as seen by the writer.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \returns The number of elements or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_rcu_size(const vec_rcu_t *vec, size_t sizeof_type) {
+	if (!vec || !vec->readers || sizeof_type != vec->sizeof_type) {
+		vec_set_err("Invalid arguments in vec_rcu_size().");
+		return (size_t)-1;
+	}
+
+	struct vec_rcu_buf *buf = atomic_load_explicit(&vec->buf, memory_order_acquire);
+
+	return atomic_load_explicit(&buf->size, memory_order_acquire);
+}
+
+/** Takes a snapshot of the vector. The snapshot stays valid until the
+ * matching vec_rcu_read_end() call, regardless of concurrent pushes.
+ * A reader can only hold one snapshot at a time; calling this again
+ * before vec_rcu_read_end() fails.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param reader The slot index of the calling reader.
+ * \param snapshot A pointer to the snapshot to be filled in.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_rcu_read_begin(vec_rcu_t *vec, size_t sizeof_type, size_t reader, vec_rcu_snapshot_t *snapshot) {
+	if (!vec || !vec->readers || !snapshot || sizeof_type != vec->sizeof_type ||
+		reader >= vec->readers_len
+	) {
+		vec_set_err("Invalid arguments in vec_rcu_read_begin().");
+		return 1;
+	}
+
+	if (atomic_load_explicit(&vec->readers[reader].epoch, memory_order_relaxed)) {
+		vec_set_err("Reader already holds a snapshot in vec_rcu_read_begin().");
+		return 1;
+	}
+
+	atomic_store(&vec->readers[reader].epoch, atomic_load(&vec->epoch));
+	struct vec_rcu_buf *buf = atomic_load(&vec->buf);
+
+	snapshot->data = buf->data;
+	snapshot->size = atomic_load_explicit(&buf->size, memory_order_acquire);
+
+	return 0;
+}
+
+/** Releases the snapshot taken by a reader.
+ * \param vec A pointer to the vector.
+ * \param reader The slot index of the calling reader. */
+void vec_rcu_read_end(vec_rcu_t *vec, size_t reader) {
+	if (vec && vec->readers && reader < vec->readers_len) {
+		atomic_store(&vec->readers[reader].epoch, 0);
+	}
+}
+
+/** Cleans up all the allocated data associated with the vector. Must only
+ * be called once no reader holds a snapshot.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type. */
+void vec_rcu_del(vec_rcu_t *vec, size_t sizeof_type) {
+	if (vec && vec->readers && vec->sizeof_type == sizeof_type) {
+		while (vec->retired) {
+			struct vec_rcu_buf *next = vec->retired->next;
+			free(vec->retired);
+			vec->retired = next;
+		}
+		free(atomic_load(&vec->buf));
+		vec_aligned_free(vec->readers);
+		free(vec);
+	}
+}
@@ -0,0 +1,250 @@
+/*
+MIT License
+
+Copyright (c) 2025 broskobandi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/** \file src/vec_sharded.c
+ * \brief Implementation file for the sharded vector.
+ * \details This file contains the implementation of all the functions
+ * declared in vec_sharded.h. */
+
+#include "vec_sharded.h"
+#include "vec_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/** A shard slot taking a whole cache line of the aligned slot array.
+ * The vec_t header, which every push updates, is not part of the slot.
+ * It is allocated by the owning thread on its first push, so it comes
+ * from that thread's allocation rather than sitting next to the headers
+ * of the other shards. */
+struct vec_shard {
+
+	/** The shard or NULL if nothing has been pushed to it yet. */
+	vec_t *vec;
+
+	/** Padding up to VEC_CACHE_LINE. */
+	uint8_t pad[VEC_CACHE_LINE - sizeof(vec_t*)];
+};
+
+/** Opaque sharded vector type. */
+struct vec_sharded {
+
+	/** The shards. */
+	struct vec_shard *shards;
+
+	/** The number of shards. */
+	size_t shards_len;
+
+	/** The size of the underlying type. */
+	size_t sizeof_type;
+};
+
+/** Creates a new vec_sharded_t on the heap. The shards themselves are
+ * allocated by the first push to each of them.
+ * \param sizeof_type The size of the underlying type.
+ * \param shards The number of shards.
+ * \returns A pointer to the allocated vector object or NULL
+ * on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+vec_sharded_t *vec_sharded_new(size_t sizeof_type, size_t shards) {
+	if (!sizeof_type || !shards) {
+		vec_set_err("Invalid arguments in vec_sharded_new().");
+		return NULL;
+	}
+
+	vec_sharded_t *vec = calloc(1, sizeof(vec_sharded_t));
+	if (!vec) {
+		vec_set_err("Failed to allocate vec_sharded_t.");
+		return NULL;
+	}
+
+	vec->shards = vec_aligned_calloc(shards, sizeof(struct vec_shard), VEC_CACHE_LINE);
+	if (!vec->shards) {
+		free(vec);
+		return NULL;
+	}
+
+	vec->shards_len = shards;
+	vec->sizeof_type = sizeof_type;
+
+	return vec;
+}
+
+/** Appends an element at the end of a shard. Must only be called by
+ * the thread owning the shard.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param shard The index of the shard.
+ * \param data A pointer to the data to be appended.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_sharded_push(vec_sharded_t *vec, size_t sizeof_type, size_t shard, const void *data) {
+	if (!vec || !vec->shards || !data || sizeof_type != vec->sizeof_type ||
+		shard >= vec->shards_len
+	) {
+		vec_set_err("Invalid arguments in vec_sharded_push().");
+		return 1;
+	}
+
+	struct vec_shard *s = &vec->shards[shard];
+	if (!s->vec) {
+		s->vec = vec_new(sizeof_type);
+		if (!s->vec) {
+			return 1;
+		}
+	}
+
+	return vec_push(s->vec, sizeof_type, data);
+}
+
+/** Get a specific shard as a plain vector. Must only be called by the
+ * thread owning the shard or after all appends have finished.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param shard The index of the shard.
+ * \returns A pointer to the shard or NULL on failure or if nothing has
+ * been pushed to it yet.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+vec_t *vec_sharded_shard(vec_sharded_t *vec, size_t sizeof_type, size_t shard) {
+	if (!vec || !vec->shards || sizeof_type != vec->sizeof_type ||
+		shard >= vec->shards_len
+	) {
+		vec_set_err("Invalid arguments in vec_sharded_shard().");
+		return NULL;
+	}
+
+	return vec->shards[shard].vec;
+}
+
+/** Get the number of shards.
+ * \param vec A pointer to the vector.
+ * \returns The number of shards or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_sharded_shards(const vec_sharded_t *vec) {
+	if (!vec || !vec->shards) {
+		vec_set_err("Invalid arguments in vec_sharded_shards().");
+		return (size_t)-1;
+	}
+
+	return vec->shards_len;
+}
+
+/** Get the total number of elements in all the shards. Must only be
+ * called after all appends have finished.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \returns The number of elements or (size_t)-1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+size_t vec_sharded_size(const vec_sharded_t *vec, size_t sizeof_type) {
+	if (!vec || !vec->shards || sizeof_type != vec->sizeof_type) {
+		vec_set_err("Invalid arguments in vec_sharded_size().");
+		return (size_t)-1;
+	}
+
+	size_t size = 0;
+	for (size_t i = 0; i < vec->shards_len; i++) {
+		if (vec->shards[i].vec) {
+			size += vec_size(vec->shards[i].vec, sizeof_type);
+		}
+	}
+
+	return size;
+}
+
+/** Get a const reference to a specific member of the merged view, in which
+ * the shards follow each other in order. Must only be called after all
+ * appends have finished.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param index The index of the element in the merged view.
+ * \returns A const pointer to the element or NULL on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+const void *vec_sharded_at_const(const vec_sharded_t *vec, size_t sizeof_type, size_t index) {
+	if (!vec || !vec->shards || sizeof_type != vec->sizeof_type) {
+		vec_set_err("Invalid arguments in vec_sharded_at_const().");
+		return NULL;
+	}
+
+	for (size_t i = 0; i < vec->shards_len; i++) {
+		if (!vec->shards[i].vec) {
+			continue;
+		}
+		size_t size = vec_size(vec->shards[i].vec, sizeof_type);
+		if (index < size) {
+			return vec_at_const(vec->shards[i].vec, sizeof_type, index);
+		}
+		index -= size;
+	}
+
+	vec_set_err("Out of bounds index passed to vec_sharded_at_const().");
+	return NULL;
+}
+
+/** Appends the merged view to a plain vector. Must only be called after
+ * all appends have finished.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type.
+ * \param dst A pointer to the destination vector.
+ * \returns 0 on success or 1 on failure.
+ * In the event of failure, the generated error string can be queried with
+ * vec_get_err(). */
+int vec_sharded_merge(const vec_sharded_t *vec, size_t sizeof_type, vec_t *dst) {
+	if (!vec || !vec->shards || !dst || sizeof_type != vec->sizeof_type) {
+		vec_set_err("Invalid arguments in vec_sharded_merge().");
+		return 1;
+	}
+
+	for (size_t i = 0; i < vec->shards_len; i++) {
+		const vec_t *shard = vec->shards[i].vec;
+		if (!shard || !vec_size(shard, sizeof_type)) {
+			continue;
+		}
+		if (vec_append(
+			dst, sizeof_type, vec_at_const(shard, sizeof_type, 0),
+			vec_size(shard, sizeof_type)
+		)) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/** Cleans up all the allocated data associated with the vector.
+ * \param vec A pointer to the vector.
+ * \param sizeof_type The size of the underlying type. */
+void vec_sharded_del(vec_sharded_t *vec, size_t sizeof_type) {
+	if (vec && vec->shards && vec->sizeof_type == sizeof_type) {
+		for (size_t i = 0; i < vec->shards_len; i++) {
+			vec_del(vec->shards[i].vec, sizeof_type);
+		}
+		vec_aligned_free(vec->shards);
+		free(vec);
+	}
+}
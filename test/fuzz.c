@@ -0,0 +1,49 @@
+/* libFuzzer target driving the generic vec_t functions against the
+ * reference model in model.h. Build and run it with 'make fuzz'.
+ * Compiling with -DVEC_FUZZ_STANDALONE adds a main() that replays the
+ * inputs given as arguments, which is handy for reproducing crashes with
+ * compilers that lack libFuzzer.
+ * Input layout: the first byte selects the element size, the second the
+ * initial capacity, and every following group of three bytes an operation
+ * and its argument. Element data is taken from the input itself. */
+
+#include "model.h"
+
+#define OP_BYTES 3LU
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+	if (size < 2) return 0;
+
+	size_t sizeof_type = 1 + data[0] % 32;
+	size_t capacity = data[1] % 64;
+	uint8_t elems[32 * MODEL_MAX_APPEND];
+	model_t m;
+	model_init(&m, sizeof_type, capacity);
+
+	for (size_t i = 2; i + OP_BYTES <= size; i += OP_BYTES) {
+		for (size_t j = 0; j < sizeof(elems); j++) {
+			elems[j] = data[(i + j) % size];
+		}
+		size_t arg = (size_t)data[i + 1] | (size_t)data[i + 2] << 8;
+		model_apply(&m, data[i], arg, elems);
+		model_check(&m, 1);
+	}
+
+	model_del(&m);
+
+	return 0;
+}
+
+#ifdef VEC_FUZZ_STANDALONE
+int main(int argc, char **argv) {
+	for (int i = 1; i < argc; i++) {
+		FILE *file = fopen(argv[i], "rb");
+		CHECK(file);
+		uint8_t buf[1 << 16];
+		size_t size = fread(buf, 1, sizeof(buf), file);
+		fclose(file);
+		LLVMFuzzerTestOneInput(buf, size);
+	}
+	return 0;
+}
+#endif
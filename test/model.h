@@ -0,0 +1,168 @@
+/* Reference model shared by the stress harness and the fuzz target.
+ * Every operation is applied both to a vec_t and to a plain byte array,
+ * and the two are compared afterwards. Failures abort regardless of
+ * NDEBUG so sanitizer and fuzzer builds report them as crashes. */
+
+#ifndef MODEL_H
+#define MODEL_H
+
+#include "vec.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond)\
+	do {\
+		if (!(cond)) {\
+			fprintf(stderr, "%s:%d: check failed: %s\n%s",\
+				__FILE__, __LINE__, #cond, vec_get_err());\
+			abort();\
+		}\
+	} while (0)
+
+/** The largest number of elements appended by a single OP_APPEND. */
+#define MODEL_MAX_APPEND 8LU
+
+enum model_op {
+	OP_PUSH,
+	OP_POP,
+	OP_INSERT,
+	OP_REMOVE,
+	OP_CLEAR,
+	OP_SET,
+	OP_APPEND,
+	OP_RESERVE_COMMIT,
+	OP_COUNT
+};
+
+typedef struct model {
+	vec_t *vec;
+	uint8_t *ref;
+	size_t len;
+	size_t cap;
+	size_t sizeof_type;
+} model_t;
+
+static inline void model_init(model_t *m, size_t sizeof_type, size_t capacity) {
+	memset(m, 0, sizeof(model_t));
+	m->sizeof_type = sizeof_type;
+	m->vec = capacity ?
+		vec_new_with_capacity(sizeof_type, capacity) : vec_new(sizeof_type);
+	CHECK(m->vec);
+	CHECK(vec_capacity(m->vec, sizeof_type) == (capacity ? capacity : 32));
+}
+
+static inline void model_reserve(model_t *m, size_t len) {
+	if (len <= m->cap) return;
+	m->cap = len * 2;
+	m->ref = realloc(m->ref, m->cap * m->sizeof_type);
+	CHECK(m->ref);
+}
+
+/** Compares the size and capacity of the vector against the model and
+ * the contents too if full is set. */
+static inline void model_check(const model_t *m, int full) {
+	size_t size = vec_size(m->vec, m->sizeof_type);
+	CHECK(size == m->len);
+	CHECK(vec_capacity(m->vec, m->sizeof_type) >= size);
+	if (full && m->len) {
+		const uint8_t *data = vec_at_const(m->vec, m->sizeof_type, 0);
+		CHECK(data);
+		CHECK(!memcmp(data, m->ref, m->len * m->sizeof_type));
+	}
+}
+
+/** Applies an operation to both the vector and the model.
+ * \param arg Selects the index of the element and the number of appended
+ * elements.
+ * \param elems Points to MODEL_MAX_APPEND elements of data. */
+static inline void model_apply(model_t *m, unsigned op, size_t arg, const uint8_t *elems) {
+	size_t sz = m->sizeof_type;
+	size_t index = m->len ? arg % (m->len + 1) : arg % 2;
+
+	switch (op % OP_COUNT) {
+		case OP_PUSH:
+			CHECK(!vec_push(m->vec, sz, elems));
+			model_reserve(m, m->len + 1);
+			memcpy(m->ref + m->len * sz, elems, sz);
+			m->len++;
+			break;
+		case OP_POP:
+			if (!m->len) {
+				CHECK(vec_pop(m->vec, sz));
+				break;
+			}
+			CHECK(!vec_pop(m->vec, sz));
+			m->len--;
+			break;
+		case OP_INSERT:
+			if (index >= m->len) {
+				CHECK(vec_insert(m->vec, sz, index, elems));
+				break;
+			}
+			CHECK(!vec_insert(m->vec, sz, index, elems));
+			model_reserve(m, m->len + 1);
+			memmove(m->ref + (index + 1) * sz, m->ref + index * sz, (m->len - index) * sz);
+			memcpy(m->ref + index * sz, elems, sz);
+			m->len++;
+			break;
+		case OP_REMOVE:
+			if (index >= m->len) {
+				CHECK(vec_remove(m->vec, sz, index));
+				break;
+			}
+			CHECK(!vec_remove(m->vec, sz, index));
+			memmove(m->ref + index * sz, m->ref + (index + 1) * sz, (m->len - index - 1) * sz);
+			m->len--;
+			break;
+		case OP_CLEAR:
+			CHECK(!vec_clear(m->vec, sz));
+			m->len = 0;
+			break;
+		case OP_SET: {
+			uint8_t *elem = vec_at(m->vec, sz, index);
+			if (index >= m->len) {
+				CHECK(!elem);
+				break;
+			}
+			CHECK(elem);
+			CHECK(!memcmp(elem, m->ref + index * sz, sz));
+			memcpy(elem, elems, sz);
+			memcpy(m->ref + index * sz, elems, sz);
+			break;
+		}
+		case OP_APPEND: {
+			size_t count = arg % (MODEL_MAX_APPEND + 1);
+			CHECK(!vec_append(m->vec, sz, elems, count));
+			model_reserve(m, m->len + count);
+			if (count) memcpy(m->ref + m->len * sz, elems, count * sz);
+			m->len += count;
+			break;
+		}
+		case OP_RESERVE_COMMIT: {
+			size_t reserved = arg % (2 * MODEL_MAX_APPEND + 1);
+			size_t filled = (arg / 3) % (MODEL_MAX_APPEND + 1);
+			if (filled > reserved) filled = reserved;
+			uint8_t *spare = vec_reserve(m->vec, sz, reserved);
+			CHECK(spare);
+			size_t capacity = vec_capacity(m->vec, sz);
+			CHECK(capacity >= m->len + reserved);
+			CHECK(vec_commit(m->vec, sz, capacity - m->len + 1));
+			if (filled) memcpy(spare, elems, filled * sz);
+			CHECK(!vec_commit(m->vec, sz, filled));
+			model_reserve(m, m->len + filled);
+			if (filled) memcpy(m->ref + m->len * sz, elems, filled * sz);
+			m->len += filled;
+			break;
+		}
+	}
+}
+
+static inline void model_del(model_t *m) {
+	vec_del(m->vec, m->sizeof_type);
+	free(m->ref);
+	memset(m, 0, sizeof(model_t));
+}
+
+#endif
@@ -0,0 +1,267 @@
+/* Randomized stress test of the generic vec_t functions against the
+ * reference model in model.h, followed by multithreaded tests of the
+ * concurrent vector types. Build and run it with 'make stress', which
+ * compiles the library sources with ASan and UBSan, or with 'make tsan'
+ * for ThreadSanitizer. Run 'make stress SAN_FLAGS=' to get throughput
+ * figures without the sanitizer overhead.
+ * Usage: stress [seed] [rounds] */
+
+#include "model.h"
+#include "vec_io.h"
+#include "vec_rcu.h"
+#include "vec_sharded.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+#define OPS_PER_ROUND 20000LU
+#define OPS_PER_PHASE 2500LU
+#define THROUGHPUT_OPS 4000000LU
+#define THREADS 8LU
+#define THREAD_PUSHES 200000LU
+#define RCU_READERS 4LU
+#define RCU_PUSHES 1000000LU
+#define PIPE_RECORDS 20000LU
+
+static uint64_t g_rng = 0x9e3779b97f4a7c15LU;
+
+static uint64_t rng(void) {
+	g_rng ^= g_rng << 13;
+	g_rng ^= g_rng >> 7;
+	g_rng ^= g_rng << 17;
+	return g_rng;
+}
+
+/** Picks an operation, favouring growth or shrinking depending on the
+ * phase so both the expanding and the shrinking paths get exercised. */
+static unsigned pick_op(int growing) {
+	unsigned roll = (unsigned)(rng() % 100);
+	if (roll < (growing ? 35U : 10U)) return OP_PUSH;
+	if (roll < 40) return OP_APPEND;
+	if (roll < 45) return OP_RESERVE_COMMIT;
+	if (roll < 55) return OP_INSERT;
+	if (roll < 70) return OP_SET;
+	if (roll < 71) return OP_CLEAR;
+	if (roll < 85) return OP_REMOVE;
+	return OP_POP;
+}
+
+static double seconds(clock_t start) {
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/** Returns the elapsed wall clock time, as clock() adds up the CPU time
+ * of all the threads. */
+static double wall_seconds(const struct timespec *start) {
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (double)(now.tv_sec - start->tv_sec) +
+		(double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static vec_sharded_t *g_sharded;
+
+/** Pushes THREAD_PUSHES tagged values to the shard of the thread. */
+static void *sharded_pusher(void *arg) {
+	size_t shard = (size_t)arg;
+	for (size_t i = 0; i < THREAD_PUSHES; i++) {
+		uint64_t value = (uint64_t)shard << 32 | i;
+		CHECK(!vec_sharded_push(g_sharded, sizeof(uint64_t), shard, &value));
+	}
+	return NULL;
+}
+
+/** Pushes from THREADS threads at once and checks the merged view. */
+static void stress_sharded(void) {
+	g_sharded = vec_sharded_new(sizeof(uint64_t), THREADS);
+	CHECK(g_sharded);
+
+	pthread_t threads[THREADS];
+	struct timespec start;
+	timespec_get(&start, TIME_UTC);
+	for (size_t i = 0; i < THREADS; i++) {
+		CHECK(!pthread_create(&threads[i], NULL, sharded_pusher, (void*)i));
+	}
+	for (size_t i = 0; i < THREADS; i++) {
+		CHECK(!pthread_join(threads[i], NULL));
+	}
+	double elapsed = wall_seconds(&start);
+
+	CHECK(vec_sharded_size(g_sharded, sizeof(uint64_t)) == THREADS * THREAD_PUSHES);
+	for (size_t i = 0; i < THREADS * THREAD_PUSHES; i++) {
+		const uint64_t *value = vec_sharded_at_const(g_sharded, sizeof(uint64_t), i);
+		CHECK(value);
+		CHECK(*value == ((uint64_t)(i / THREAD_PUSHES) << 32 | i % THREAD_PUSHES));
+	}
+	printf("Pushed %lu values from %lu threads in %.3fs (%.2f Mops/s)\n",
+		THREADS * THREAD_PUSHES, THREADS, elapsed,
+		(double)(THREADS * THREAD_PUSHES) / elapsed / 1e6);
+
+	vec_sharded_del(g_sharded, sizeof(uint64_t));
+}
+
+/** Writes PIPE_RECORDS 4-byte records split into 1 and 3 byte writes. */
+static void *pipe_writer(void *arg) {
+	int fd = *(int*)arg;
+	for (uint32_t i = 0; i < PIPE_RECORDS; i++) {
+		const uint8_t *bytes = (const uint8_t*)&i;
+		CHECK(write(fd, bytes, 1) == 1);
+		CHECK(write(fd, bytes + 1, 3) == 3);
+	}
+	CHECK(!close(fd));
+	return NULL;
+}
+
+/** Reads records from a non-blocking pipe while they arrive in pieces.
+ * Every record has to come out whole and in order. */
+static void stress_pipe(void) {
+	int fds[2];
+	CHECK(!pipe(fds));
+	CHECK(fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0);
+	vec_t *vec = vec_new(sizeof(uint32_t));
+	CHECK(vec);
+
+	pthread_t writer;
+	CHECK(!pthread_create(&writer, NULL, pipe_writer, &fds[1]));
+	size_t would_block = 0;
+	for (;;) {
+		size_t n = vec_io_read(vec, sizeof(uint32_t), fds[0], 64);
+		if (n == VEC_IO_WOULD_BLOCK) {
+			would_block++;
+			continue;
+		}
+		CHECK(n != (size_t)-1);
+		if (!n) break;
+	}
+	CHECK(!pthread_join(writer, NULL));
+
+	CHECK(vec_size(vec, sizeof(uint32_t)) == PIPE_RECORDS);
+	for (size_t i = 0; i < PIPE_RECORDS; i++) {
+		CHECK(*(const uint32_t*)vec_at_const(vec, sizeof(uint32_t), i) == (uint32_t)i);
+	}
+	printf("Read %lu split records from a non-blocking pipe (%zu empty reads)\n",
+		PIPE_RECORDS, would_block);
+
+	vec_del(vec, sizeof(uint32_t));
+	CHECK(!close(fds[0]));
+}
+
+static vec_rcu_t *g_rcu;
+static atomic_int g_rcu_done;
+
+/** Scans snapshots until the writer is done. Every element a snapshot
+ * covers must hold its own index. */
+static void *rcu_reader(void *arg) {
+	size_t reader = (size_t)arg;
+	size_t scans = 0;
+	size_t last_size = 0;
+
+	while (!atomic_load(&g_rcu_done)) {
+		vec_rcu_snapshot_t snap;
+		CHECK(!vec_rcu_read_begin(g_rcu, sizeof(uint32_t), reader, &snap));
+		CHECK(snap.size >= last_size);
+		const uint32_t *data = snap.data;
+		for (size_t i = scans % 7; i < snap.size; i += 7) {
+			CHECK(data[i] == (uint32_t)i);
+		}
+		if (snap.size) CHECK(data[snap.size - 1] == (uint32_t)(snap.size - 1));
+		last_size = snap.size;
+		vec_rcu_read_end(g_rcu, reader);
+		scans++;
+	}
+
+	return (void*)scans;
+}
+
+/** Appends from one writer while RCU_READERS threads scan snapshots. */
+static void stress_rcu(void) {
+	g_rcu = vec_rcu_new(sizeof(uint32_t), 1, RCU_READERS);
+	CHECK(g_rcu);
+	atomic_store(&g_rcu_done, 0);
+
+	pthread_t readers[RCU_READERS];
+	for (size_t i = 0; i < RCU_READERS; i++) {
+		CHECK(!pthread_create(&readers[i], NULL, rcu_reader, (void*)i));
+	}
+
+	struct timespec start;
+	timespec_get(&start, TIME_UTC);
+	for (uint32_t i = 0; i < RCU_PUSHES; i++) {
+		CHECK(!vec_rcu_push(g_rcu, sizeof(uint32_t), &i));
+	}
+	double elapsed = wall_seconds(&start);
+	atomic_store(&g_rcu_done, 1);
+
+	size_t scans = 0;
+	for (size_t i = 0; i < RCU_READERS; i++) {
+		void *reader_scans;
+		CHECK(!pthread_join(readers[i], &reader_scans));
+		scans += (size_t)reader_scans;
+	}
+
+	CHECK(vec_rcu_size(g_rcu, sizeof(uint32_t)) == RCU_PUSHES);
+	CHECK(vec_rcu_reclaim(g_rcu) == 0);
+	printf("Pushed %lu values in %.3fs (%.2f Mops/s) during %zu scans by %lu readers\n",
+		RCU_PUSHES, elapsed, (double)RCU_PUSHES / elapsed / 1e6, scans, RCU_READERS);
+
+	vec_rcu_del(g_rcu, sizeof(uint32_t));
+}
+
+int main(int argc, char **argv) {
+	uint64_t seed = argc > 1 ? strtoull(argv[1], NULL, 0) : (uint64_t)time(NULL);
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 64;
+	g_rng = seed ? seed : 1;
+	printf("Stress seed: %llu\n", (unsigned long long)seed);
+
+	uint8_t elems[64 * MODEL_MAX_APPEND];
+	size_t ops = 0;
+	clock_t start = clock();
+
+	for (size_t round = 0; round < rounds; round++) {
+		size_t sizeof_type = 1 + rng() % 64;
+		size_t capacity = rng() % 2 ? 0 : 1 + rng() % 100;
+		model_t m;
+		model_init(&m, sizeof_type, capacity);
+
+		for (size_t i = 0; i < OPS_PER_ROUND; i++, ops++) {
+			for (size_t j = 0; j < sizeof_type * MODEL_MAX_APPEND; j++) {
+				elems[j] = (uint8_t)rng();
+			}
+			int growing = (i / OPS_PER_PHASE) % 2 == 0;
+			model_apply(&m, pick_op(growing), (size_t)rng(), elems);
+			model_check(&m, i % 64 == 0);
+		}
+
+		model_check(&m, 1);
+		model_del(&m);
+	}
+
+	double checked = seconds(start);
+	printf("Checked %zu ops in %.3fs (%.2f Mops/s)\n",
+		ops, checked, (double)ops / checked / 1e6);
+
+	vec_t *vec = vec_new(sizeof(int));
+	CHECK(vec);
+	start = clock();
+	for (size_t i = 0; i < THROUGHPUT_OPS; i++) {
+		int value = (int)i;
+		CHECK(!vec_push(vec, sizeof(int), &value));
+	}
+	for (size_t i = 0; i < THROUGHPUT_OPS; i++) {
+		CHECK(!vec_pop(vec, sizeof(int)));
+	}
+	double unchecked = seconds(start);
+	printf("Pushed and popped %lu ints in %.3fs (%.2f Mops/s)\n",
+		THROUGHPUT_OPS, unchecked, 2.0 * (double)THROUGHPUT_OPS / unchecked / 1e6);
+	vec_del(vec, sizeof(int));
+
+	stress_sharded();
+	stress_rcu();
+	stress_pipe();
+
+	printf("Stress test passed.\n");
+
+	return 0;
+}
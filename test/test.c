@@ -1,9 +1,17 @@
 #include "vec.h"
+#include "vec_io.h"
+#include "vec_packed.h"
+#include "vec_rcu.h"
+#include "vec_sharded.h"
 #include <assert.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
 
 VEC_TYPEDEF(int);
 VEC_TYPEDEF(float);
+VEC_TYPEDEF(long);
 
 int main(void) {
 	{ // NEW / DEL / CAPACITY
@@ -80,6 +88,206 @@ int main(void) {
 		VEC_DEL(vec);
 	}
 
+	{ // APPEND
+		VEC(int) vec = VEC_NEW(int);
+		int values[100];
+		for (int i = 0; i < 100; i++) values[i] = i;
+		assert(!vec_append(vec.__priv, sizeof(int), values, 100));
+		assert(VEC_SIZE(vec) == 100);
+		assert(VEC_CAPACITY(vec) >= 100);
+		assert(*VEC_AT_CONST(vec, 99) == 99);
+		assert(vec_append(vec.__priv, sizeof(double), values, 1));
+		assert(vec_append(vec.__priv, sizeof(int), values, SIZE_MAX));
+		assert(vec_append(vec.__priv, sizeof(int), values, SIZE_MAX / sizeof(int)));
+		assert(VEC_SIZE(vec) == 100);
+		assert(!vec_append(vec.__priv, sizeof(int), VEC_AT_CONST(vec, 0), 100));
+		assert(VEC_SIZE(vec) == 200);
+		assert(*VEC_AT_CONST(vec, 199) == 99);
+		VEC_DEL(vec);
+	}
+
+	{ // PACKED
+		vec_packed_t *packed = vec_packed_new();
+		assert(packed);
+		int64_t value = 0;
+		assert(vec_packed_at(packed, 0, &value));
+		for (int64_t i = 0; i < 1000; i++) {
+			assert(!vec_packed_push(packed, 1700000000000 + i * 7 - (i % 3)));
+		}
+		assert(!vec_packed_push(packed, INT64_MIN));
+		assert(!vec_packed_push(packed, INT64_MAX));
+		assert(vec_packed_size(packed) == 1002);
+		assert(vec_packed_bytes(packed) < 1002 * sizeof(int64_t));
+		for (int64_t i = 0; i < 1000; i++) {
+			assert(!vec_packed_at(packed, (size_t)i, &value));
+			assert(value == 1700000000000 + i * 7 - (i % 3));
+		}
+		assert(!vec_packed_at(packed, 1000, &value));
+		assert(value == INT64_MIN);
+		assert(!vec_packed_at(packed, 1001, &value));
+		assert(value == INT64_MAX);
+		assert(vec_packed_at(packed, 1002, &value));
+		VEC(long) vec = VEC_NEW(long);
+		assert(!vec_packed_decode(packed, vec.__priv, sizeof(long)));
+		assert(VEC_SIZE(vec) == 1002);
+		for (size_t i = 0; i < 1000; i++) {
+			assert(*VEC_AT_CONST(vec, i) == 1700000000000 + (long)i * 7 - (long)(i % 3));
+		}
+		assert(*VEC_AT_CONST(vec, 1001) == INT64_MAX);
+		VEC_DEL(vec);
+		for (int64_t i = 0; i < 254; i++) {
+			assert(!vec_packed_push(packed, (i % 2) ? INT64_MIN : INT64_MAX));
+		}
+		assert(!vec_packed_at(packed, 1002 + 253, &value));
+		assert(value == INT64_MIN);
+		assert(!vec_packed_at(packed, 1002 + 200, &value));
+		assert(value == INT64_MAX);
+		VEC(int) vec2 = VEC_NEW(int);
+		assert(!vec_packed_decode(packed, vec2.__priv, sizeof(int)));
+		assert(*VEC_AT_CONST(vec2, 5) == (int)(1700000000000 + 5 * 7 - 2));
+		assert(vec_packed_decode(packed, vec2.__priv, 3));
+		VEC_DEL(vec2);
+		vec_packed_del(packed);
+	}
+
+	{ // SHARDED
+		assert(!vec_sharded_new(sizeof(int), 0));
+		vec_sharded_t *sharded = vec_sharded_new(sizeof(int), 4);
+		assert(sharded);
+		assert(vec_sharded_shards(sharded) == 4);
+		assert(!vec_sharded_shard(sharded, sizeof(int), 1));
+		for (int i = 0; i < 100; i++) {
+			assert(!vec_sharded_push(sharded, sizeof(int), (size_t)i % 3, &i));
+		}
+		assert(vec_sharded_push(sharded, sizeof(int), 4, &(int){0}));
+		assert(vec_sharded_push(sharded, sizeof(long), 0, &(long){0}));
+		assert(vec_size(vec_sharded_shard(sharded, sizeof(int), 1), sizeof(int)) == 33);
+		assert(vec_sharded_size(sharded, sizeof(int)) == 100);
+		assert(*(const int*)vec_sharded_at_const(sharded, sizeof(int), 0) == 0);
+		assert(*(const int*)vec_sharded_at_const(sharded, sizeof(int), 34) == 1);
+		assert(*(const int*)vec_sharded_at_const(sharded, sizeof(int), 99) == 98);
+		assert(!vec_sharded_at_const(sharded, sizeof(int), 100));
+		VEC(int) vec = VEC_NEW(int);
+		assert(!vec_sharded_merge(sharded, sizeof(int), vec.__priv));
+		assert(VEC_SIZE(vec) == 100);
+		assert(*VEC_AT_CONST(vec, 33) == 99);
+		assert(*VEC_AT_CONST(vec, 67) == 2);
+		VEC_DEL(vec);
+		vec_sharded_del(sharded, sizeof(int));
+	}
+
+	{ // RCU
+		assert(!vec_rcu_new(sizeof(int), 4, 0));
+		assert(!vec_rcu_new(8, SIZE_MAX / 8 + 1, 1));
+		assert(!vec_rcu_new(8, SIZE_MAX / 8, 1));
+		vec_rcu_t *rcu = vec_rcu_new(sizeof(int), 4, 2);
+		assert(rcu);
+		for (int i = 0; i < 4; i++) {
+			assert(!vec_rcu_push(rcu, sizeof(int), &i));
+		}
+		vec_rcu_snapshot_t snap;
+		assert(vec_rcu_read_begin(rcu, sizeof(int), 2, &snap));
+		assert(!vec_rcu_read_begin(rcu, sizeof(int), 1, &snap));
+		assert(snap.size == 4);
+		vec_rcu_snapshot_t again;
+		assert(vec_rcu_read_begin(rcu, sizeof(int), 1, &again));
+		for (int i = 4; i < 100; i++) {
+			assert(!vec_rcu_push(rcu, sizeof(int), &i));
+		}
+		assert(vec_rcu_size(rcu, sizeof(int)) == 100);
+		assert(vec_rcu_reclaim(rcu) > 0);
+		assert(snap.size == 4);
+		for (size_t i = 0; i < snap.size; i++) {
+			assert(((const int*)snap.data)[i] == (int)i);
+		}
+		vec_rcu_read_end(rcu, 1);
+		assert(vec_rcu_reclaim(rcu) == 0);
+		assert(!vec_rcu_read_begin(rcu, sizeof(int), 0, &snap));
+		assert(snap.size == 100);
+		assert(((const int*)snap.data)[99] == 99);
+		vec_rcu_read_end(rcu, 0);
+		assert(vec_rcu_push(rcu, sizeof(long), &(long){0}));
+		vec_rcu_del(rcu, sizeof(int));
+	}
+
+	{ // RESERVE / COMMIT
+		VEC(int) vec = VEC_NEW(int);
+		VEC_PUSH(vec, 1);
+		int *spare = vec_reserve(vec.__priv, sizeof(int), 100);
+		assert(spare);
+		assert(VEC_CAPACITY(vec) >= 101);
+		assert(VEC_SIZE(vec) == 1);
+		spare[0] = 2;
+		spare[1] = 3;
+		assert(!vec_commit(vec.__priv, sizeof(int), 2));
+		assert(VEC_SIZE(vec) == 3);
+		assert(*VEC_AT_CONST(vec, 2) == 3);
+		assert(vec_commit(vec.__priv, sizeof(int), VEC_CAPACITY(vec)));
+		assert(!vec_reserve(vec.__priv, sizeof(int), SIZE_MAX / sizeof(int) + 2));
+		assert(!vec_reserve(vec.__priv, sizeof(int), SIZE_MAX));
+		assert(VEC_CAPACITY(vec) < SIZE_MAX / sizeof(int));
+		assert(VEC_SIZE(vec) == 3);
+		VEC_DEL(vec);
+	}
+
+	{ // IO
+		FILE *file = tmpfile();
+		assert(file);
+		int fd = fileno(file);
+		VEC(int) out = VEC_NEW(int);
+		for (int i = 0; i < 400000; i++) VEC_PUSH(out, i);
+		assert(!vec_io_write(out.__priv, sizeof(int), fd));
+		assert(write(fd, "xy", 2) == 2);
+		VEC_DEL(out);
+
+		VEC(int) in = VEC_NEW(int);
+		assert(vec_io_read_at(in.__priv, sizeof(int), fd, 0, 800000, 8) == 400000);
+		assert(VEC_SIZE(in) == 400000);
+		for (size_t i = 0; i < 400000; i++) assert(*VEC_AT_CONST(in, i) == (int)i);
+		VEC_CLEAR(in);
+		assert(vec_io_read_at(in.__priv, sizeof(int), fd, 40, 100, 1) == 100);
+		assert(*VEC_AT_CONST(in, 0) == 10);
+		assert(*VEC_AT_CONST(in, 99) == 109);
+		assert(vec_io_read_at(in.__priv, sizeof(int), fd, 1600000, 10, 4) == 0);
+		VEC_CLEAR(in);
+		assert(vec_io_read_at(in.__priv, sizeof(int), fd, 1599960, (size_t)1 << 28, 4) == 10);
+		assert(VEC_CAPACITY(in) < 1000);
+		assert(*VEC_AT_CONST(in, 9) == 399999);
+		assert(vec_io_read_at(in.__priv, sizeof(long), fd, 0, 10, 4) == (size_t)-1);
+		VEC_CLEAR(in);
+
+		assert(lseek(fd, 0, SEEK_SET) == 0);
+		assert(vec_io_read(in.__priv, sizeof(int), fd, 50) == 50);
+		assert(*VEC_AT_CONST(in, 49) == 49);
+		while (vec_io_read(in.__priv, sizeof(int), fd, 4096) != 0);
+		assert(VEC_SIZE(in) == 400000);
+		assert(*VEC_AT_CONST(in, 399999) == 399999);
+		VEC_DEL(in);
+		fclose(file);
+
+		int fds[2];
+		assert(!pipe(fds));
+		assert(write(fds[1], "abcd", 4) == 4);
+		VEC(int) piped = VEC_NEW(int);
+		VEC_PUSH(piped, 1);
+		assert(vec_io_read(piped.__priv, sizeof(int), fds[0], SIZE_MAX) == (size_t)-1);
+		assert(VEC_SIZE(piped) == 1);
+		assert(vec_io_read(piped.__priv, sizeof(int), fds[0], 16) == 1);
+		assert(VEC_SIZE(piped) == 2);
+		assert(fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0);
+		assert(vec_io_read(piped.__priv, sizeof(int), fds[0], 16) == VEC_IO_WOULD_BLOCK);
+		assert(write(fds[1], "abcdefgh", 8) == 8);
+		assert(vec_io_read(piped.__priv, sizeof(int), fds[0], 1) == 1);
+		assert(vec_io_read(piped.__priv, sizeof(int), fds[0], 16) == 1);
+		assert(vec_io_read(piped.__priv, sizeof(int), fds[0], 16) == VEC_IO_WOULD_BLOCK);
+		assert(VEC_SIZE(piped) == 4);
+		assert(!memcmp(VEC_AT_CONST(piped, 3), "efgh", 4));
+		assert(vec_io_read(piped.__priv, sizeof(int), fds[1], 16) == (size_t)-1);
+		VEC_DEL(piped);
+		close(fds[0]);
+		close(fds[1]);
+	}
+
 	printf("All tests passed.\n");
 	
 	return 0;